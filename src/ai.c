@@ -4,7 +4,46 @@
 #include "gamelogic.h"
 
 
-WinStatus ai_player_move(ChessBoard board, ChessPlayer *player)
+#define UNTIMED_MOVE_MS       1000 /** Thinking time per move in an untimed game. */
+#define MOVE_OVERHEAD_MS      50   /** Time kept in reserve for UI latency on every move. */
+#define EXPECTED_GAME_MOVES   60   /** Moves per player assumed when planning time use. */
+#define MIN_MOVES_TO_GO       20   /** Always plan for at least this many moves left. */
+#define HARD_LIMIT_FACTOR     4    /** How much longer than planned a move may take. */
+#define MAX_SHARE_OF_CLOCK    4    /** A move may use at most 1/MAX_SHARE_OF_CLOCK of the clock. */
+
+
+WinStatus ai_player_move(ChessBoard board, ChessPlayer *player, const AiTimeBudget *budget)
 {
+    (void)budget; // Unused until there is a search to limit.
     return false;
 }
+
+void ai_allocate_time(const ChessClock *clock, int moves_played, AiTimeBudget *budget)
+{
+    if (!clock->enabled) {
+        budget->soft = UNTIMED_MOVE_MS;
+        budget->hard = UNTIMED_MOVE_MS;
+        return;
+    }
+
+    long long available = clock->remaining - MOVE_OVERHEAD_MS;
+    if (available < 1) {
+        available = 1;
+    }
+
+    int moves_to_go = EXPECTED_GAME_MOVES - moves_played;
+    if (moves_to_go < MIN_MOVES_TO_GO) {
+        moves_to_go = MIN_MOVES_TO_GO;
+    }
+
+    // Most of the increment can be spent, since it is returned after the move.
+    budget->soft = available / moves_to_go + clock->increment * 3 / 4;
+    budget->hard = budget->soft * HARD_LIMIT_FACTOR;
+
+    if (budget->hard > available / MAX_SHARE_OF_CLOCK) {
+        budget->hard = available / MAX_SHARE_OF_CLOCK;
+    }
+    if (budget->soft > budget->hard) {
+        budget->soft = budget->hard;
+    }
+}
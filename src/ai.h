@@ -12,9 +12,22 @@
 #include "gamelogic.h"
 
 
+/** How long the AI may think about a single move, in milliseconds. */
+typedef struct {
+    long long soft; /** Do not start another search iteration after this much time. */
+    long long hard; /** Always stop searching after this much time. */
+} AiTimeBudget;
+
+
+/**
+ * Have the AI make a valid move, thinking for no longer than `budget` allows.
+ */
+WinStatus ai_player_move(ChessBoard board, ChessPlayer *player, const AiTimeBudget *budget);
+
 /**
- * Have the AI make a valid move.
+ * Split the time left on `clock` into a budget for the next move, given the
+ * number of moves the player has already made. Untimed games get a fixed budget.
  */
-WinStatus ai_player_move(ChessBoard board, ChessPlayer *player);
+void ai_allocate_time(const ChessClock *clock, int moves_played, AiTimeBudget *budget);
 
 #endif
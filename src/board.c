@@ -1,10 +1,35 @@
 #define _XOPEN_SOURCE_EXTENDED
 
+#include <string.h>
+
 #include <ncursesw/curses.h>
 
 #include "board.h"
 
 
+// Color pairs used to draw the board.
+#define PAIR_LIGHT_SQUARE     1
+#define PAIR_DARK_SQUARE      2
+#define PAIR_HIGHLIGHT_SQUARE 3
+
+/** The standard starting position, kept in read-only data so that no loop has
+    to fill it in at runtime. */
+static const ChessBoard initial_board = {
+    { PC_BLACK_ROOK, PC_BLACK_KNIGHT, PC_BLACK_BISHOP, PC_BLACK_QUEEN,
+      PC_BLACK_KING, PC_BLACK_BISHOP, PC_BLACK_KNIGHT, PC_BLACK_ROOK },
+    { PC_BLACK_PAWN, PC_BLACK_PAWN, PC_BLACK_PAWN, PC_BLACK_PAWN,
+      PC_BLACK_PAWN, PC_BLACK_PAWN, PC_BLACK_PAWN, PC_BLACK_PAWN },
+    { PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL },
+    { PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL },
+    { PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL },
+    { PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL, PC_NULL },
+    { PC_WHITE_PAWN, PC_WHITE_PAWN, PC_WHITE_PAWN, PC_WHITE_PAWN,
+      PC_WHITE_PAWN, PC_WHITE_PAWN, PC_WHITE_PAWN, PC_WHITE_PAWN },
+    { PC_WHITE_ROOK, PC_WHITE_KNIGHT, PC_WHITE_BISHOP, PC_WHITE_QUEEN,
+      PC_WHITE_KING, PC_WHITE_BISHOP, PC_WHITE_KNIGHT, PC_WHITE_ROOK },
+};
+
+
 /** Draw a horizontal line to `data`, given a total `width` and optional left
     padding with spaces. The first and last characters of the line of the line
     will be `start_char` and `end_char`, respectively. The `data` buffer must
@@ -15,93 +40,153 @@ static void create_horizontal_line(wchar_t data[], int width, int left_padding,
 /** Given a ChessPiece, return the corresponding wchar_t. */
 static wchar_t get_symbol_for_piece(ChessPiece piece);
 
+/** Mark everything in `view` as needing to be redrawn on the next render. */
+static void invalidate_view(BoardView *view);
+
+/** Return whether the square at `row`, `col` was part of the last move. */
+static bool is_last_move_square(const BoardView *view, int row, int col);
+
+/** Draw the border, rank numbers and file letters around the board. */
+static void render_frame(BoardView *view);
+
+/** Draw a single square of the board, given in board (not screen) coordinates. */
+static void render_square(BoardView *view, int row, int col, ChessPiece piece, bool highlight);
+
 
 void brd_init(ChessBoard board)
 {
-    // Initialize empty squares and pawns.
+    memcpy(board, initial_board, sizeof initial_board);
+}
+
+void brd_init_colors(void)
+{
+    init_pair(PAIR_LIGHT_SQUARE, COLOR_BLACK, COLOR_WHITE);
+    init_pair(PAIR_DARK_SQUARE, COLOR_WHITE, COLOR_BLACK);
+    init_pair(PAIR_HIGHLIGHT_SQUARE, COLOR_BLACK, COLOR_YELLOW);
+}
+
+void brd_view_init(BoardView *view, WINDOW *win, bool flipped)
+{
+    view->win = win;
+    view->flipped = flipped;
+    view->last_move_from[0] = view->last_move_from[1] = -1;
+    view->last_move_to[0] = view->last_move_to[1] = -1;
+    invalidate_view(view);
+}
+
+void brd_view_set_flipped(BoardView *view, bool flipped)
+{
+    if (view->flipped != flipped) {
+        view->flipped = flipped;
+        invalidate_view(view);
+    }
+}
+
+void brd_view_set_last_move(BoardView *view, const int from_position[2], const int to_position[2])
+{
+    view->last_move_from[0] = from_position ? from_position[0] : -1;
+    view->last_move_from[1] = from_position ? from_position[1] : -1;
+    view->last_move_to[0] = to_position ? to_position[0] : -1;
+    view->last_move_to[1] = to_position ? to_position[1] : -1;
+}
+
+void brd_render(ChessBoard board, BoardView *view)
+{
+    if (!view->frame_drawn) {
+        render_frame(view);
+        view->frame_drawn = true;
+    }
+
     for (int row = 0; row < BRD_SIZE; row++) {
         for (int col = 0; col < BRD_SIZE; col++) {
-            if (row == 1) {
-                board[row][col] = PC_BLACK_PAWN;
-            } else if (row == BRD_SIZE - 2) {
-                board[row][col] = PC_WHITE_PAWN;
-            } else {
-                board[row][col] = PC_NULL;
+            bool highlight = is_last_move_square(view, row, col);
+
+            if (view->square_drawn[row][col] && view->drawn_board[row][col] == board[row][col]
+                    && view->drawn_highlight[row][col] == highlight) {
+                continue;
             }
+
+            render_square(view, row, col, board[row][col], highlight);
+            view->drawn_board[row][col] = board[row][col];
+            view->drawn_highlight[row][col] = highlight;
+            view->square_drawn[row][col] = true;
         }
     }
-
-    // Initialize all other pieces manually.
-    board[0][0] = PC_BLACK_ROOK;
-    board[0][1] = PC_BLACK_KNIGHT;
-    board[0][2] = PC_BLACK_BISHOP;
-    board[0][3] = PC_BLACK_QUEEN;
-    board[0][4] = PC_BLACK_KING;
-    board[0][5] = PC_BLACK_BISHOP;
-    board[0][6] = PC_BLACK_KNIGHT;
-    board[0][7] = PC_BLACK_ROOK;
-
-    board[7][0] = PC_WHITE_ROOK;
-    board[7][1] = PC_WHITE_KNIGHT;
-    board[7][2] = PC_WHITE_BISHOP;
-    board[7][3] = PC_WHITE_QUEEN;
-    board[7][4] = PC_WHITE_KING;
-    board[7][5] = PC_WHITE_BISHOP;
-    board[7][6] = PC_WHITE_KNIGHT;
-    board[7][7] = PC_WHITE_ROOK;
 }
 
-void brd_render(ChessBoard board, WINDOW *win)
+void brd_clear(BoardView *view)
 {
-    wmove(win, 0, 0);
-
-    init_pair(1, COLOR_BLACK, COLOR_WHITE);
-    init_pair(2, COLOR_WHITE, COLOR_BLACK);
+    werase(view->win);
+    invalidate_view(view);
+}
 
-    wchar_t top_line[20] = {0};
-    create_horizontal_line(top_line, 20, 1, SYMBOL_BOX_TOP_LEFT, SYMBOL_BOX_TOP_RIGHT);
-    waddwstr(win, top_line);
+static void invalidate_view(BoardView *view)
+{
+    view->frame_drawn = false;
+    memset(view->square_drawn, 0, sizeof view->square_drawn);
+}
 
-    for (int row = 0; row < BRD_SIZE; row++) {
-        // Print the left side of each row. Ex: 2|
-        wchar_t left_side[3] = { 0 };
-        swprintf(left_side, 3, L"%d%lc", 8 - row, SYMBOL_BOX_VERTICAL);
-        waddwstr(win, left_side);
+static bool is_last_move_square(const BoardView *view, int row, int col)
+{
+    return (view->last_move_from[0] == row && view->last_move_from[1] == col)
+        || (view->last_move_to[0] == row && view->last_move_to[1] == col);
+}
 
-        // Print 8 positions in the row. Each position is two characters wide
-        // to compensate for character width/height ratio.
-        for (int col = 0; col < BRD_SIZE; col++) {
-            cchar_t first_char, second_char;
-            int color_pair_num = (row % 2 == col % 2) ? 1 : 2;
-            wchar_t chess_piece = get_symbol_for_piece(board[row][col]);
+static void render_frame(BoardView *view)
+{
+    WINDOW *win = view->win;
 
-            setcchar(&first_char, &chess_piece, WA_NORMAL, color_pair_num, NULL);
-            setcchar(&second_char, L" ", WA_NORMAL, color_pair_num, NULL);
+    wchar_t top_line[BRD_RENDER_WIDTH + 1] = {0};
+    create_horizontal_line(top_line, BRD_RENDER_WIDTH, 1, SYMBOL_BOX_TOP_LEFT, SYMBOL_BOX_TOP_RIGHT);
+    mvwaddwstr(win, 0, 0, top_line);
 
-            wadd_wch(win, &first_char);
-            wadd_wch(win, &second_char);
-        }
+    for (int screen_row = 0; screen_row < BRD_SIZE; screen_row++) {
+        // Print the sides of each row. Ex: 2|                |
+        int rank = view->flipped ? screen_row + 1 : BRD_SIZE - screen_row;
+        wchar_t left_side[3] = { 0 };
+        swprintf(left_side, 3, L"%d%lc", rank, SYMBOL_BOX_VERTICAL);
+        mvwaddwstr(win, screen_row + 1, 0, left_side);
 
-        // Print a vertical line and newline at the end of the row.
-        wchar_t right_side[3] = { SYMBOL_BOX_VERTICAL, L'\n', 0 };
-        waddwstr(win, right_side);
+        wchar_t right_side[2] = { SYMBOL_BOX_VERTICAL, 0 };
+        mvwaddwstr(win, screen_row + 1, 2 + 2 * BRD_SIZE, right_side);
     }
 
-    wchar_t bottom_line[20] = {0};
-    create_horizontal_line(bottom_line, 20, 1, SYMBOL_BOX_BOT_LEFT, SYMBOL_BOX_BOT_RIGHT);
-    waddwstr(win, bottom_line);
+    wchar_t bottom_line[BRD_RENDER_WIDTH + 1] = {0};
+    create_horizontal_line(bottom_line, BRD_RENDER_WIDTH, 1, SYMBOL_BOX_BOT_LEFT, SYMBOL_BOX_BOT_RIGHT);
+    mvwaddwstr(win, BRD_SIZE + 1, 0, bottom_line);
 
     // Letters at the bottom of the board.
+    wmove(win, BRD_SIZE + 2, 0);
     waddwstr(win, L"  ");
-    for (int col = 0; col < BRD_SIZE; col++) {
-        wchar_t letter[3] = { L'A' + col, L' ', 0 };
+    for (int screen_col = 0; screen_col < BRD_SIZE; screen_col++) {
+        int file = view->flipped ? BRD_SIZE - 1 - screen_col : screen_col;
+        wchar_t letter[3] = { L'A' + file, L' ', 0 };
         waddwstr(win, letter);
     }
 }
 
-void brd_clear(WINDOW *win)
+static void render_square(BoardView *view, int row, int col, ChessPiece piece, bool highlight)
 {
-    werase(win);
+    int screen_row = view->flipped ? BRD_SIZE - 1 - row : row;
+    int screen_col = view->flipped ? BRD_SIZE - 1 - col : col;
+
+    short color_pair_num;
+    if (highlight) {
+        color_pair_num = PAIR_HIGHLIGHT_SQUARE;
+    } else {
+        color_pair_num = (row % 2 == col % 2) ? PAIR_LIGHT_SQUARE : PAIR_DARK_SQUARE;
+    }
+
+    // Each position is two characters wide to compensate for character
+    // width/height ratio.
+    cchar_t first_char, second_char;
+    wchar_t chess_piece = get_symbol_for_piece(piece);
+
+    setcchar(&first_char, &chess_piece, WA_NORMAL, color_pair_num, NULL);
+    setcchar(&second_char, L" ", WA_NORMAL, color_pair_num, NULL);
+
+    mvwadd_wch(view->win, screen_row + 1, 2 + 2 * screen_col, &first_char);
+    wadd_wch(view->win, &second_char);
 }
 
 static void create_horizontal_line(wchar_t data[], int width, int left_padding,
@@ -6,6 +6,7 @@
 
 #define _XOPEN_SOURCE_EXTENDED
 
+#include <stdbool.h>
 #include <wchar.h>
 
 #include <ncursesw/curses.h>
@@ -63,6 +64,23 @@ typedef enum {
 /** Represents a standard chess board. */
 typedef ChessPiece ChessBoard[BRD_SIZE][BRD_SIZE];
 
+/**
+ * Remembers what has already been drawn to a board window, so that each render
+ * only redraws the squares that changed since the previous one.
+ */
+typedef struct {
+    WINDOW *win;                                  /** The window the board is drawn to. */
+    bool flipped;                                 /** Whether black is drawn at the bottom. */
+    bool frame_drawn;                             /** Whether the border and coordinates are on screen. */
+
+    ChessBoard drawn_board;                       /** The pieces currently on screen. */
+    bool drawn_highlight[BRD_SIZE][BRD_SIZE];     /** The highlighted squares currently on screen. */
+    bool square_drawn[BRD_SIZE][BRD_SIZE];        /** Whether a square has been drawn since the last clear. */
+
+    int last_move_from[2];                        /** The row, col of the last human move's origin, or -1. */
+    int last_move_to[2];                          /** The row, col of the last human move's destination, or -1. */
+} BoardView;
+
 
 /**
  * Initialize a chess board by overwriting all pieces. White is always at the
@@ -71,11 +89,34 @@ typedef ChessPiece ChessBoard[BRD_SIZE][BRD_SIZE];
 void brd_init(ChessBoard board);
 
 /**
- * Draw a chess board to `win`. The window must be at least 11 rows by 19 columns.
+ * Initialize the color pairs used to draw the board. Must be called once after
+ * start_color and before the first call to `brd_render`.
+ */
+void brd_init_colors(void);
+
+/**
+ * Initialize `view` to draw to `win`. Nothing is assumed to be on screen, so the
+ * next render draws the whole board.
+ */
+void brd_view_init(BoardView *view, WINDOW *win, bool flipped);
+
+/** Choose whether black is drawn at the bottom. Changing it redraws everything. */
+void brd_view_set_flipped(BoardView *view, bool flipped);
+
+/**
+ * Highlight the squares of the last move on the next render. Either position may
+ * be NULL or contain -1 if it is unknown.
+ */
+void brd_view_set_last_move(BoardView *view, const int from_position[2], const int to_position[2]);
+
+/**
+ * Draw a chess board to the view's window, only updating the squares that have
+ * changed since the last render. The window must be at least 11 rows by 20
+ * columns. Does not refresh the window.
  */
-void brd_render(ChessBoard board, WINDOW *win);
+void brd_render(ChessBoard board, BoardView *view);
 
-/** Clear the board window. */
-void brd_clear(WINDOW *win);
+/** Clear the board window and forget everything that was drawn to it. */
+void brd_clear(BoardView *view);
 
 #endif
@@ -12,10 +12,23 @@
 #include "board.h"
 
 
+// The most time a ChessClock may hold, and the largest increment it may have, in
+// milliseconds.
+#define CLOCK_MAX_MS (7LL * 24 * 60 * 60 * 1000)
+
+
+/** A player's chess clock. All times are in milliseconds. */
+typedef struct {
+    bool enabled;        /** Whether the player's thinking time is limited. */
+    long long remaining; /** Time left on the clock. */
+    long long increment; /** Time added to the clock after each move the player makes. */
+} ChessClock;
+
 /** Represents a person or computer that can play chess. */
 typedef struct {
-    bool is_white; /** Whether the player is playing as white/black. */
-    bool is_human; /** Whether the player is a human or bot. */
+    bool is_white;    /** Whether the player is playing as white/black. */
+    bool is_human;    /** Whether the player is a human or bot. */
+    ChessClock clock; /** The player's remaining time. */
 } ChessPlayer;
 
 /** An enumeration of all possible move types. */
@@ -0,0 +1,370 @@
+#define _XOPEN_SOURCE_EXTENDED
+
+#include <stdio.h>
+#include <string.h>
+
+#include "gamerecord.h"
+
+
+#define REC_MAGIC   "CHYG"
+#define REC_VERSION 1
+
+// Sizes of the parts of a record file, in bytes.
+#define REC_PREAMBLE_SIZE 8                               /** Magic, version, flags, result, reserved. */
+#define REC_CLOCK_SIZE    17                              /** Enabled flag, remaining and increment. */
+#define REC_HEADER_SIZE   (REC_PREAMBLE_SIZE + 2 * REC_CLOCK_SIZE + BRD_SIZE * BRD_SIZE + 4)
+#define REC_MAX_FILE_SIZE (REC_HEADER_SIZE + 2 * REC_MAX_MOVES)
+
+// Bits of the flags byte.
+#define REC_FLAG_WHITE_HUMAN       0x01
+#define REC_FLAG_BLACK_HUMAN       0x02
+#define REC_FLAG_WHITE_MOVES_FIRST 0x04
+#define REC_FLAG_LOST_ON_TIME      0x08
+#define REC_FLAG_ALL               (REC_FLAG_WHITE_HUMAN | REC_FLAG_BLACK_HUMAN | REC_FLAG_WHITE_MOVES_FIRST \
+                                    | REC_FLAG_LOST_ON_TIME)
+
+// A move is stored as the destination square in bits 0-5, the origin square in
+// bits 6-11 and one of the kinds below in bits 12-15. Squares are numbered
+// row * BRD_SIZE + col.
+#define MOVE_KIND_NORMAL              0
+#define MOVE_KIND_CASTLING            1
+#define MOVE_KIND_QUEEN_SIDE_CASTLING 2
+#define MOVE_KIND_DRAW_OFFER          3
+#define MOVE_KIND_PROMOTE_QUEEN       4
+#define MOVE_KIND_PROMOTE_ROOK        5
+#define MOVE_KIND_PROMOTE_BISHOP      6
+#define MOVE_KIND_PROMOTE_KNIGHT      7
+
+
+/** Encode `chess_move` into `encoded`. Return false if it cannot be represented. */
+static bool encode_move(const ChessMove *chess_move, uint16_t *encoded);
+
+/**
+ * Decode `encoded` into `chess_move` for `player`, reading the moved piece from
+ * `board`. Return false if the encoding is invalid.
+ */
+static bool decode_move(uint16_t encoded, ChessBoard board, ChessPlayer *player, ChessMove *chess_move);
+
+/** Return the promotion move kind for `piece`, or MOVE_KIND_NORMAL if it is not a promotion. */
+static int promotion_kind(ChessPiece piece);
+
+/** Store the little-endian `value` of `size` bytes at `data`, and return the position after it. */
+static unsigned char *put_uint(unsigned char *data, uint64_t value, int size);
+
+/** Read a little-endian value of `size` bytes at `data`. */
+static uint64_t get_uint(const unsigned char *data, int size);
+
+
+void rec_init(GameRecord *record, ChessBoard start_board, const ChessPlayer *white, const ChessPlayer *black)
+{
+    record->white_is_human = white->is_human;
+    record->black_is_human = black->is_human;
+    record->white_moves_first = true;
+    record->result = WS_CONTINUE;
+    record->lost_on_time = false;
+
+    record->white_clock = white->clock;
+    record->black_clock = black->clock;
+
+    memcpy(record->start_board, start_board, sizeof record->start_board);
+    record->num_moves = 0;
+}
+
+bool rec_add_move(GameRecord *record, const ChessMove *chess_move)
+{
+    if (record->num_moves >= REC_MAX_MOVES) {
+        return false;
+    }
+
+    if (!encode_move(chess_move, &record->moves[record->num_moves])) {
+        return false;
+    }
+    record->num_moves++;
+    return true;
+}
+
+bool rec_replay(const GameRecord *record, ChessBoard board, int num_moves)
+{
+    ChessPlayer white_player = { true, record->white_is_human, record->white_clock };
+    ChessPlayer black_player = { false, record->black_is_human, record->black_clock };
+
+    memcpy(board, record->start_board, sizeof record->start_board);
+
+    if (num_moves > record->num_moves) {
+        num_moves = record->num_moves;
+    }
+
+    bool white_to_move = record->white_moves_first;
+    for (int i = 0; i < num_moves; i++) {
+        ChessMove chess_move;
+        ChessPlayer *player = white_to_move ? &white_player : &black_player;
+
+        if (!decode_move(record->moves[i], board, player, &chess_move) || !make_move(board, &chess_move)) {
+            return false;
+        }
+        white_to_move = !white_to_move;
+    }
+
+    return true;
+}
+
+bool rec_save(const GameRecord *record, const char *path)
+{
+    unsigned char data[REC_MAX_FILE_SIZE];
+    unsigned char *pos = data;
+
+    unsigned char flags = 0;
+    if (record->white_is_human) {
+        flags |= REC_FLAG_WHITE_HUMAN;
+    }
+    if (record->black_is_human) {
+        flags |= REC_FLAG_BLACK_HUMAN;
+    }
+    if (record->white_moves_first) {
+        flags |= REC_FLAG_WHITE_MOVES_FIRST;
+    }
+    if (record->lost_on_time) {
+        flags |= REC_FLAG_LOST_ON_TIME;
+    }
+
+    memcpy(pos, REC_MAGIC, 4);
+    pos += 4;
+    pos = put_uint(pos, REC_VERSION, 1);
+    pos = put_uint(pos, flags, 1);
+    pos = put_uint(pos, record->result, 1);
+    pos = put_uint(pos, 0, 1);
+
+    const ChessClock *clocks[2] = { &record->white_clock, &record->black_clock };
+    for (int i = 0; i < 2; i++) {
+        pos = put_uint(pos, clocks[i]->enabled, 1);
+        pos = put_uint(pos, (uint64_t)clocks[i]->remaining, 8);
+        pos = put_uint(pos, (uint64_t)clocks[i]->increment, 8);
+    }
+
+    for (int row = 0; row < BRD_SIZE; row++) {
+        for (int col = 0; col < BRD_SIZE; col++) {
+            pos = put_uint(pos, record->start_board[row][col], 1);
+        }
+    }
+
+    pos = put_uint(pos, record->num_moves, 4);
+    for (int i = 0; i < record->num_moves; i++) {
+        pos = put_uint(pos, record->moves[i], 2);
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+
+    size_t size = pos - data;
+    bool written = fwrite(data, 1, size, file) == size;
+    return fclose(file) == 0 && written;
+}
+
+bool rec_load(GameRecord *record, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    // Read one byte past the largest valid record so that oversized files are rejected.
+    unsigned char data[REC_MAX_FILE_SIZE + 1];
+    size_t size = fread(data, 1, sizeof data, file);
+    fclose(file);
+
+    if (size < REC_HEADER_SIZE || memcmp(data, REC_MAGIC, 4) != 0 || data[4] != REC_VERSION) {
+        return false;
+    }
+
+    const unsigned char *pos = data + 5;
+
+    // Unknown flags and the reserved byte must be zero so that later versions of
+    // the format can give them a meaning.
+    unsigned char flags = *pos++;
+    if (flags & ~REC_FLAG_ALL) {
+        return false;
+    }
+    record->white_is_human = flags & REC_FLAG_WHITE_HUMAN;
+    record->black_is_human = flags & REC_FLAG_BLACK_HUMAN;
+    record->white_moves_first = flags & REC_FLAG_WHITE_MOVES_FIRST;
+    record->lost_on_time = flags & REC_FLAG_LOST_ON_TIME;
+
+    unsigned char result = *pos++;
+    if (result > WS_DRAW) {
+        return false;
+    }
+    record->result = (WinStatus)result;
+
+    // Only a finished game with a winner can have been lost on time.
+    if (record->lost_on_time && (result == WS_CONTINUE || result == WS_DRAW)) {
+        return false;
+    }
+
+    if (*pos++ != 0) {
+        return false;
+    }
+
+    ChessClock *clocks[2] = { &record->white_clock, &record->black_clock };
+    for (int i = 0; i < 2; i++) {
+        if (pos[0] > 1) {
+            return false;
+        }
+
+        // Values above CLOCK_MAX_MS include those that are negative as signed.
+        uint64_t remaining = get_uint(pos + 1, 8);
+        uint64_t increment = get_uint(pos + 9, 8);
+        if (remaining > CLOCK_MAX_MS || increment > CLOCK_MAX_MS) {
+            return false;
+        }
+
+        clocks[i]->enabled = pos[0];
+        clocks[i]->remaining = (long long)remaining;
+        clocks[i]->increment = (long long)increment;
+        pos += REC_CLOCK_SIZE;
+    }
+
+    // Either both players are timed or neither is.
+    if (record->white_clock.enabled != record->black_clock.enabled) {
+        return false;
+    }
+
+    for (int row = 0; row < BRD_SIZE; row++) {
+        for (int col = 0; col < BRD_SIZE; col++) {
+            if (*pos > PC_BLACK_PAWN) {
+                return false;
+            }
+            record->start_board[row][col] = (ChessPiece)*pos++;
+        }
+    }
+
+    uint64_t num_moves = get_uint(pos, 4);
+    pos += 4;
+    if (num_moves > REC_MAX_MOVES || size != REC_HEADER_SIZE + 2 * num_moves) {
+        return false;
+    }
+
+    record->num_moves = (int)num_moves;
+    for (int i = 0; i < record->num_moves; i++) {
+        record->moves[i] = (uint16_t)get_uint(pos, 2);
+        pos += 2;
+    }
+
+    return true;
+}
+
+static bool encode_move(const ChessMove *chess_move, uint16_t *encoded)
+{
+    switch (chess_move->move_type) {
+        case SPECIAL_MOVE_CASTLING:
+            *encoded = MOVE_KIND_CASTLING << 12;
+            return true;
+        case SPECIAL_MOVE_QUEEN_SIDE_CASTLING:
+            *encoded = MOVE_KIND_QUEEN_SIDE_CASTLING << 12;
+            return true;
+        case SPECIAL_MOVE_DRAW_OFFER:
+            *encoded = MOVE_KIND_DRAW_OFFER << 12;
+            return true;
+        default:
+            break;
+    }
+
+    const int *from = chess_move->from_position, *to = chess_move->to_position;
+    if (from[0] < 0 || from[0] >= BRD_SIZE || from[1] < 0 || from[1] >= BRD_SIZE
+            || to[0] < 0 || to[0] >= BRD_SIZE || to[1] < 0 || to[1] >= BRD_SIZE) {
+        return false;
+    }
+
+    // The promotion piece is checked instead of the move type, since make_move
+    // may replace SPECIAL_MOVE_PROMOTION with a capture or check.
+    int kind = promotion_kind(chess_move->promotion_piece);
+
+    *encoded = (uint16_t)(kind << 12 | (from[0] * BRD_SIZE + from[1]) << 6 | (to[0] * BRD_SIZE + to[1]));
+    return true;
+}
+
+static bool decode_move(uint16_t encoded, ChessBoard board, ChessPlayer *player, ChessMove *chess_move)
+{
+    int kind = encoded >> 12;
+    int from = (encoded >> 6) & 0x3F;
+    int to = encoded & 0x3F;
+
+    // Fill in the move exactly as parse_algebraic_notation would.
+    chess_move->player = player;
+    chess_move->piece = PC_NULL;
+    chess_move->from_position[0] = -1;
+    chess_move->from_position[1] = -1;
+    chess_move->to_position[0] = -1;
+    chess_move->to_position[1] = -1;
+    chess_move->move_type = SPECIAL_MOVE_NULL;
+    chess_move->promotion_piece = PC_NULL;
+
+    switch (kind) {
+        case MOVE_KIND_CASTLING:
+            chess_move->move_type = SPECIAL_MOVE_CASTLING;
+            return true;
+        case MOVE_KIND_QUEEN_SIDE_CASTLING:
+            chess_move->move_type = SPECIAL_MOVE_QUEEN_SIDE_CASTLING;
+            return true;
+        case MOVE_KIND_DRAW_OFFER:
+            chess_move->move_type = SPECIAL_MOVE_DRAW_OFFER;
+            return true;
+        case MOVE_KIND_PROMOTE_QUEEN:
+            chess_move->promotion_piece = player->is_white ? PC_WHITE_QUEEN : PC_BLACK_QUEEN;
+            break;
+        case MOVE_KIND_PROMOTE_ROOK:
+            chess_move->promotion_piece = player->is_white ? PC_WHITE_ROOK : PC_BLACK_ROOK;
+            break;
+        case MOVE_KIND_PROMOTE_BISHOP:
+            chess_move->promotion_piece = player->is_white ? PC_WHITE_BISHOP : PC_BLACK_BISHOP;
+            break;
+        case MOVE_KIND_PROMOTE_KNIGHT:
+            chess_move->promotion_piece = player->is_white ? PC_WHITE_KNIGHT : PC_BLACK_KNIGHT;
+            break;
+        case MOVE_KIND_NORMAL:
+            break;
+        default:
+            return false;
+    }
+
+    if (chess_move->promotion_piece != PC_NULL) {
+        chess_move->move_type = SPECIAL_MOVE_PROMOTION;
+    }
+
+    chess_move->from_position[0] = from / BRD_SIZE;
+    chess_move->from_position[1] = from % BRD_SIZE;
+    chess_move->to_position[0] = to / BRD_SIZE;
+    chess_move->to_position[1] = to % BRD_SIZE;
+    chess_move->piece = board[from / BRD_SIZE][from % BRD_SIZE];
+
+    return chess_move->piece != PC_NULL;
+}
+
+static int promotion_kind(ChessPiece piece)
+{
+    switch (piece) {
+        case PC_WHITE_QUEEN: case PC_BLACK_QUEEN: return MOVE_KIND_PROMOTE_QUEEN;
+        case PC_WHITE_ROOK: case PC_BLACK_ROOK: return MOVE_KIND_PROMOTE_ROOK;
+        case PC_WHITE_BISHOP: case PC_BLACK_BISHOP: return MOVE_KIND_PROMOTE_BISHOP;
+        case PC_WHITE_KNIGHT: case PC_BLACK_KNIGHT: return MOVE_KIND_PROMOTE_KNIGHT;
+        default: return MOVE_KIND_NORMAL;
+    }
+}
+
+static unsigned char *put_uint(unsigned char *data, uint64_t value, int size)
+{
+    for (int i = 0; i < size; i++) {
+        data[i] = (unsigned char)(value >> (8 * i));
+    }
+    return data + size;
+}
+
+static uint64_t get_uint(const unsigned char *data, int size)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value |= (uint64_t)data[i] << (8 * i);
+    }
+    return value;
+}
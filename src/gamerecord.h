@@ -0,0 +1,66 @@
+/**
+ * A compact binary format for saving, loading and replaying chess games.
+ *
+ * A record file starts with a header holding the player types, the result, both
+ * clocks and the starting board, followed by every move encoded in 16 bits.
+ * All multi-byte values are stored little-endian.
+ */
+#ifndef CHESS_GAME_RECORD_H
+#define CHESS_GAME_RECORD_H
+
+#define _XOPEN_SOURCE_EXTENDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "gamelogic.h"
+
+
+#define REC_MAX_MOVES 2048 /** The most moves (plies) a record can hold. */
+
+
+/** A complete game that can be saved to or loaded from a file. */
+typedef struct {
+    bool white_is_human;           /** Whether white is played by a human. */
+    bool black_is_human;           /** Whether black is played by a human. */
+    bool white_moves_first;        /** Whether white is to move in `start_board`. */
+    WinStatus result;              /** WS_CONTINUE while the game is unfinished. */
+    bool lost_on_time;             /** Whether the loser of a finished game ran out of time. */
+
+    ChessClock white_clock;        /** White's clock at the time the record was made. */
+    ChessClock black_clock;        /** Black's clock at the time the record was made. */
+
+    ChessBoard start_board;        /** The position the game started from. */
+
+    int num_moves;                 /** The number of moves in `moves`. */
+    uint16_t moves[REC_MAX_MOVES]; /** The encoded moves, in the order they were played. */
+} GameRecord;
+
+
+/**
+ * Start a new record of a game played from `start_board` between `white` and
+ * `black`.
+ */
+void rec_init(GameRecord *record, ChessBoard start_board, const ChessPlayer *white, const ChessPlayer *black);
+
+/**
+ * Append `chess_move` to the record. The move must have been completed by
+ * `make_move`, so that both its from and to positions are known. Return false if
+ * the move cannot be encoded or the record is full.
+ */
+bool rec_add_move(GameRecord *record, const ChessMove *chess_move);
+
+/**
+ * Play the first `num_moves` moves of the record onto `board`, starting from the
+ * record's start board. Return false if a stored move is rejected by `make_move`.
+ */
+bool rec_replay(const GameRecord *record, ChessBoard board, int num_moves);
+
+/** Write the record to the file at `path`. Return true only on success. */
+bool rec_save(const GameRecord *record, const char *path);
+
+/** Read a record from the file at `path`. Return true only if it is a valid record. */
+bool rec_load(GameRecord *record, const char *path);
+
+#endif
@@ -4,13 +4,15 @@
  * Implements UI and user input handling functions.
  */
 #define _XOPEN_SOURCE_EXTENDED
+#define _POSIX_C_SOURCE 199309L
 
 #include <locale.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <unistd.h>
+#include <time.h>
 #include <wctype.h>
 
 #include <ncursesw/curses.h>
@@ -18,46 +20,145 @@
 #include "ai.h"
 #include "board.h"
 #include "gamelogic.h"
+#include "gamerecord.h"
 
 
 #define INPUT_BUF_SIZE 20 /** The size of the input buffer used by prompt_win. */
+#define PATH_BUF_SIZE  PATH_MAX /** The size of the buffers used for file names. */
+
+#define PROMPT_WIN_HEIGHT 2 /** The prompt window has a status line above the input line. */
+#define PROMPT_STATUS_ROW 0
+#define PROMPT_INPUT_ROW  1
+
+#define STATUS_ERROR_MS 2000 /** How long an error message stays on the status line. */
+
+
+/** The clocks of the game being played and the window they are shown in. */
+typedef struct {
+    WINDOW *win;          /** The window the clocks are drawn to. */
+    ChessPlayer *white;   /** The white player, or NULL outside of a game. */
+    ChessPlayer *black;   /** The black player, or NULL outside of a game. */
+    ChessPlayer *running; /** The player whose clock is counting down, or NULL. */
+    long long started_at; /** Monotonic time in milliseconds at which the running clock started. */
+} GameClocks;
+
+
+/**
+ * Monotonic time in milliseconds at which the status line should be cleared,
+ * or 0 if the current status message does not expire.
+ */
+static long long status_expires_at = 0;
+
+/** The last status message without a duration, shown again when a timed message expires. */
+static const wchar_t *persistent_status = L"";
+
+/** The clocks shown while a game is being played. */
+static GameClocks game_clocks = { 0 };
 
 
 /** Play a game of chess again and again until the user decides to quit. */
 static void interactive_session(WINDOW *game_win, WINDOW *prompt_win);
 
 /** Play a single chess game. */
-static void play_game(WINDOW *game_win, WINDOW *prompt_win);
+static void play_game(BoardView *board_view, WINDOW *prompt_win);
 
 /** Initialize a player's type by prompting the user. */
 static void init_player_type(WINDOW *prompt_win, ChessPlayer *player);
 
+/** Initialize both players' clocks by prompting the user for a time control. */
+static void init_time_control(WINDOW *prompt_win, ChessPlayer *white_player, ChessPlayer *black_player);
+
+/**
+ * Offer to resume a saved game. If the user picks one, store it in `record`, play
+ * its moves onto `board` and return true. Return false for a new game.
+ */
+static bool load_game(WINDOW *prompt_win, GameRecord *record, ChessBoard board);
+
+/** Ask the user for a file name and save `record` to it, with the clocks as they are now. */
+static void save_game(WINDOW *prompt_win, GameRecord *record);
+
 /**
- * Ask the player for a move. The return value signifies whether the game should
- * end. Only return a valid move, by prompting the user repeatedly if it is invalid.
+ * Ask the player for a move and store the move that was made in `chosen_move`.
+ * The return value signifies whether the game should end. Only return a valid
+ * move, by prompting the user repeatedly if it is invalid, unless the player's
+ * clock runs out first. The player may save `record` instead of moving, unless
+ * it is NULL.
  */
-static WinStatus human_player_move(WINDOW *prompt_win, ChessBoard board, ChessPlayer *player);
+static WinStatus human_player_move(WINDOW *prompt_win, ChessBoard board, ChessPlayer *player,
+                                   GameRecord *record, ChessMove *chosen_move);
 
 /********** Prompt window utilities **********/
 
-/** Clear the prompt window. Do not refresh. */
-static void prompt_win_clear(WINDOW *win);
+/**
+ * Display a message on the status line of the prompt window and refresh it. If
+ * `duration_ms` is 0, the message stays until replaced; `message` must then stay
+ * valid, since it is shown again whenever a timed message expires. Otherwise the
+ * previous such message returns after `duration_ms` milliseconds. Never blocks;
+ * the input line remains usable.
+ */
+static void prompt_win_message(WINDOW *win, const wchar_t *message, int duration_ms);
+
+/**
+ * Wait for a key like wget_wch, handling timed events such as expiring status
+ * messages while no input is available.
+ */
+static int prompt_win_get_wch(WINDOW *win, wint_t *ch);
+
+/** Return the current time in milliseconds from a monotonic clock. */
+static long long monotonic_ms(void);
 
-/** Display a prompt to the prompt window and refresh it. */
-static void prompt_win_message(WINDOW *win, const wchar_t *message);
+/**
+ * Prompt the user for an answer up to `max_length` characters long and store it
+ * in `response`, which must hold `max_length` + 1 characters. Refresh the window
+ * as needed, but do not refresh once the user has submitted their answer. Return
+ * false if input was aborted before it was submitted, such as when the running
+ * clock runs out; `response` then holds what was typed so far.
+ */
+static bool prompt_win_input(WINDOW *win, const wchar_t *prompt, wchar_t response[], int max_length);
 
 /**
- * Prompt the user for an answer up to `INPUT_BUF_SIZE` characters long. Refresh
- * the window as needed, but do not refresh once the user has submitted their
- * answer.
+ * Show the end of the first `length` characters of `response` on the input line,
+ * starting at column `start_col`, and refresh the window.
  */
-static void prompt_win_input(WINDOW *win, const wchar_t *prompt, wchar_t response[INPUT_BUF_SIZE + 1]);
+static void prompt_win_echo(WINDOW *win, int start_col, const wchar_t *response, int length);
 
 /**
  * Prompt the user and parse the input like wscanf.
  */
 static int prompt_win_wscanf(WINDOW *win, const wchar_t *prompt, const wchar_t *format, ...);
 
+/**
+ * Prompt the user for a file name and store it in `path`. Return false if the
+ * answer is blank, was aborted, or cannot be converted to a path.
+ */
+static bool prompt_win_path(WINDOW *win, const wchar_t *prompt, char path[PATH_BUF_SIZE]);
+
+/********** Clock utilities **********/
+
+/** Start counting down `player`'s clock. */
+static void clocks_start(ChessPlayer *player);
+
+/**
+ * Stop the running clock, charging the elapsed time and adding the increment.
+ * Return false if the player ran out of time.
+ */
+static bool clocks_stop(void);
+
+/** Return whether the running clock has run out. */
+static bool clocks_flag_fell(void);
+
+/** Return the time left on `player`'s clock, including the running time. */
+static long long clocks_remaining(const ChessPlayer *player);
+
+/**
+ * Return the number of milliseconds until the displayed time changes, or -1 if
+ * no timed clock is running.
+ */
+static int clocks_next_tick_ms(void);
+
+/** Draw the clocks to their window. Only marks the window for refresh. */
+static void clocks_render(void);
+
 
 int main(void)
 {
@@ -71,6 +172,7 @@ int main(void)
         return EXIT_FAILURE;
     }
     start_color();
+    brd_init_colors();
 
     cbreak();
     noecho();
@@ -92,8 +194,12 @@ int main(void)
     // Game board
     WINDOW *game_win = newwin(BRD_RENDER_HEIGHT, BRD_RENDER_WIDTH, 1, (cols - BRD_RENDER_WIDTH) / 2);
 
+    // Clock window
+    game_clocks.win = newwin(1, cols, BRD_RENDER_HEIGHT + 1, 0);
+
     // Prompt window
-    WINDOW *prompt_win = newwin(1, cols, BRD_RENDER_HEIGHT + 1, 0);
+    WINDOW *prompt_win = newwin(PROMPT_WIN_HEIGHT, cols, BRD_RENDER_HEIGHT + 2, 0);
+    keypad(prompt_win, TRUE);
 
     // Play the game!
     interactive_session(game_win, prompt_win);
@@ -104,11 +210,14 @@ int main(void)
 
 static void interactive_session(WINDOW *game_win, WINDOW *prompt_win)
 {
+    BoardView board_view;
+    brd_view_init(&board_view, game_win, false);
+
     while (true) {
-        wclear(game_win);
+        brd_clear(&board_view);
         wrefresh(game_win);
 
-        play_game(game_win, prompt_win);
+        play_game(&board_view, prompt_win);
 
         wchar_t play_again;
         if (prompt_win_wscanf(prompt_win, L"Do you want to play again? [y/N] ", L"%lc", &play_again) == 1) {
@@ -120,28 +229,63 @@ static void interactive_session(WINDOW *game_win, WINDOW *prompt_win)
     }
 }
 
-static void play_game(WINDOW *game_win, WINDOW *prompt_win)
+static void play_game(BoardView *board_view, WINDOW *prompt_win)
 {
     ChessPlayer white_player, black_player;
-
     white_player.is_white = true;
-    prompt_win_message(prompt_win, L"Configure player (white)...");
-    sleep(1);
-    init_player_type(prompt_win, &white_player);
-
     black_player.is_white = false;
-    prompt_win_message(prompt_win, L"Configure player (black)...");
-    sleep(1);
-    init_player_type(prompt_win, &black_player);
 
     ChessBoard board;
-    brd_init(board);
-
+    GameRecord record;
     bool current_player_is_white = true;
+    int white_moves_played = 0, black_moves_played = 0;
+    WinStatus game_status = WS_CONTINUE;
+    bool lost_on_time = false;
+
+    // Whether the game differs from what is saved on disk, so that it is worth saving.
+    bool modified = true;
+
+    if (load_game(prompt_win, &record, board)) {
+        white_player.is_human = record.white_is_human;
+        white_player.clock = record.white_clock;
+        black_player.is_human = record.black_is_human;
+        black_player.clock = record.black_clock;
+
+        current_player_is_white = record.white_moves_first == (record.num_moves % 2 == 0);
+        white_moves_played = (record.num_moves + record.white_moves_first) / 2;
+        black_moves_played = record.num_moves - white_moves_played;
+        game_status = record.result;
+        lost_on_time = record.lost_on_time;
+        modified = false;
+    } else {
+        prompt_win_message(prompt_win, L"Configure player (white)...", 0);
+        init_player_type(prompt_win, &white_player);
+
+        prompt_win_message(prompt_win, L"Configure player (black)...", 0);
+        init_player_type(prompt_win, &black_player);
+
+        prompt_win_message(prompt_win, L"Configure clocks...", 0);
+        init_time_control(prompt_win, &white_player, &black_player);
+
+        brd_init(board);
+        rec_init(&record, board, &white_player, &black_player);
+    }
+
+    game_clocks.white = &white_player;
+    game_clocks.black = &black_player;
+    game_clocks.running = NULL;
+
+    // Show the board from black's side when black is the only human player.
+    brd_view_set_flipped(board_view, black_player.is_human && !white_player.is_human);
+    brd_view_set_last_move(board_view, NULL, NULL);
+
+    // Whether every move so far is in `record`, so that it can still be saved.
+    bool recording = true;
 
     // Game loop.
-    WinStatus game_status = WS_CONTINUE;
     while (game_status == WS_CONTINUE) {
+        modified = true;
+
         ChessPlayer *current_player;
         if (current_player_is_white) {
             current_player = &white_player;
@@ -149,26 +293,67 @@ static void play_game(WINDOW *game_win, WINDOW *prompt_win)
             current_player = &black_player;
         }
 
-        brd_render(board, game_win);
-        wrefresh(game_win);
+        clocks_start(current_player);
 
+        brd_render(board, board_view);
+        clocks_render();
+        wrefresh(board_view->win);
+
+        ChessMove move;
         if (current_player->is_human) {
-            game_status = human_player_move(prompt_win, board, current_player);
+            game_status = human_player_move(prompt_win, board, current_player, recording ? &record : NULL, &move);
+        } else {
+            AiTimeBudget budget;
+            ai_allocate_time(&current_player->clock,
+                             current_player_is_white ? white_moves_played : black_moves_played, &budget);
+            game_status = ai_player_move(board, current_player, &budget);
+        }
+
+        if (!clocks_stop()) {
+            lost_on_time = true;
+            game_status = current_player->is_white ? WS_BLACK : WS_WHITE;
+        } else if (current_player->is_human) {
+            brd_view_set_last_move(board_view, move.from_position, move.to_position);
+
+            if (recording && !rec_add_move(&record, &move)) {
+                recording = false;
+                prompt_win_message(prompt_win, L"This move cannot be recorded; saving is disabled.", STATUS_ERROR_MS);
+            }
         } else {
-            game_status = ai_player_move(board, current_player);
+            // ai_player_move does not report the move it made, so it cannot be
+            // highlighted and the record cannot be kept in step with the board.
+            brd_view_set_last_move(board_view, NULL, NULL);
+            recording = false;
         }
 
+        if (current_player_is_white) {
+            white_moves_played++;
+        } else {
+            black_moves_played++;
+        }
         current_player_is_white = !current_player_is_white;
     }
 
+    brd_render(board, board_view);
+    wrefresh(board_view->win);
+
     if (game_status == WS_WHITE) {
-        prompt_win_message(prompt_win, L"Player 2 has won!");
+        prompt_win_message(prompt_win, lost_on_time ? L"Player 2 has won on time!" : L"Player 2 has won!", 0);
     } else if (game_status == WS_BLACK) {
-        prompt_win_message(prompt_win, L"Player 1 has won!");
+        prompt_win_message(prompt_win, lost_on_time ? L"Player 1 has won on time!" : L"Player 1 has won!", 0);
     } else {
-        prompt_win_message(prompt_win, L"A draw ocurred.");
+        prompt_win_message(prompt_win, L"A draw ocurred.", 0);
+    }
+
+    if (recording && modified) {
+        record.result = game_status;
+        record.lost_on_time = lost_on_time;
+        save_game(prompt_win, &record);
     }
-    sleep(2);
+
+    game_clocks.white = NULL;
+    game_clocks.black = NULL;
+    clocks_render();
 }
 
 static void init_player_type(WINDOW *prompt_win, ChessPlayer *player)
@@ -185,33 +370,105 @@ static void init_player_type(WINDOW *prompt_win, ChessPlayer *player)
             }
         }
         // Invalid type.
-        prompt_win_message(prompt_win, L"Invalid player type.");
+        prompt_win_message(prompt_win, L"Invalid player type.", STATUS_ERROR_MS);
+    }
+}
+
+static void init_time_control(WINDOW *prompt_win, ChessPlayer *white_player, ChessPlayer *black_player)
+{
+    while (true) {
+        wchar_t time_control[INPUT_BUF_SIZE + 1];
+        prompt_win_input(prompt_win, L"Time control [minutes+increment, blank for none]: ", time_control,
+                         INPUT_BUF_SIZE);
+
+        if (time_control[0] == L'\0') {
+            ChessClock clock = { false, 0, 0 };
+            white_player->clock = clock;
+            black_player->clock = clock;
+            break;
+        }
+
+        int minutes, increment = 0;
+        int num_read = swscanf(time_control, L"%d+%d", &minutes, &increment);
+        if (num_read >= 1 && minutes > 0 && minutes <= CLOCK_MAX_MS / (60 * 1000)
+                && increment >= 0 && increment <= CLOCK_MAX_MS / 1000) {
+            ChessClock clock = { true, minutes * 60 * 1000LL, increment * 1000LL };
+            white_player->clock = clock;
+            black_player->clock = clock;
+            break;
+        }
+
+        // Invalid time control.
+        prompt_win_message(prompt_win, L"Invalid time control. Example: 5+3", STATUS_ERROR_MS);
+    }
+}
+
+static bool load_game(WINDOW *prompt_win, GameRecord *record, ChessBoard board)
+{
+    while (true) {
+        char path[PATH_BUF_SIZE];
+        if (!prompt_win_path(prompt_win, L"Load game [file, blank for new game]: ", path)) {
+            return false;
+        }
+
+        if (!rec_load(record, path)) {
+            prompt_win_message(prompt_win, L"Could not read a saved game from that file.", STATUS_ERROR_MS);
+        } else if (!rec_replay(record, board, record->num_moves)) {
+            prompt_win_message(prompt_win, L"The saved game contains an invalid move.", STATUS_ERROR_MS);
+        } else {
+            return true;
+        }
+    }
+}
+
+static void save_game(WINDOW *prompt_win, GameRecord *record)
+{
+    char path[PATH_BUF_SIZE];
+    if (!prompt_win_path(prompt_win, L"Save game [file, blank to skip]: ", path)) {
+        return;
+    }
+
+    record->white_clock = game_clocks.white->clock;
+    record->white_clock.remaining = clocks_remaining(game_clocks.white);
+    record->black_clock = game_clocks.black->clock;
+    record->black_clock.remaining = clocks_remaining(game_clocks.black);
+
+    if (rec_save(record, path)) {
+        prompt_win_message(prompt_win, L"Game saved.", STATUS_ERROR_MS);
+    } else {
+        prompt_win_message(prompt_win, L"Could not save the game.", STATUS_ERROR_MS);
     }
 }
 
-static WinStatus human_player_move(WINDOW *prompt_win, ChessBoard board, ChessPlayer *player)
+static WinStatus human_player_move(WINDOW *prompt_win, ChessBoard board, ChessPlayer *player,
+                                   GameRecord *record, ChessMove *chosen_move)
 {
     if (player->is_white) {
-        prompt_win_message(prompt_win, L"White's turn...");
+        prompt_win_message(prompt_win, L"White's turn...", 0);
     } else {
-        prompt_win_message(prompt_win, L"Black's turn...");
+        prompt_win_message(prompt_win, L"Black's turn...", 0);
     }
-    sleep(1);
 
     while (true) {
         wchar_t move_instruction[INPUT_BUF_SIZE + 1];
-        prompt_win_input(prompt_win, L"Move (algebraic notation): ", move_instruction);
+        prompt_win_input(prompt_win, L"Move (algebraic notation): ", move_instruction, INPUT_BUF_SIZE);
 
-        ChessMove user_move;
-        if (!parse_algebraic_notation(move_instruction, player, &user_move)) {
-            prompt_win_message(prompt_win, L"Invalid move, incorrect use of algebraic notation.");
-            sleep(1);
+        if (clocks_flag_fell()) {
+            return WS_CONTINUE;
+        }
+
+        if (record && wcscmp(move_instruction, L"save") == 0) {
+            save_game(prompt_win, record);
+            continue;
+        }
+
+        if (!parse_algebraic_notation(move_instruction, player, chosen_move)) {
+            prompt_win_message(prompt_win, L"Invalid move, incorrect use of algebraic notation.", STATUS_ERROR_MS);
             continue;
         }
 
-        if (!make_move(board, &user_move)) {
-            prompt_win_message(prompt_win, L"Invalid move.");
-            sleep(1);
+        if (!make_move(board, chosen_move)) {
+            prompt_win_message(prompt_win, L"Invalid move.", STATUS_ERROR_MS);
             continue;
         } else {
             break;
@@ -222,21 +479,78 @@ static WinStatus human_player_move(WINDOW *prompt_win, ChessBoard board, ChessPl
 }
 
 /* Prompt window utilities. */
-static void prompt_win_clear(WINDOW *win)
+static void prompt_win_message(WINDOW *win, const wchar_t *message, int duration_ms)
 {
-    werase(win);
+    // Leave the cursor where it was so that any input in progress is undisturbed.
+    int cursor_row, cursor_col;
+    getyx(win, cursor_row, cursor_col);
+
+    wmove(win, PROMPT_STATUS_ROW, 0);
+    wclrtoeol(win);
+    waddwstr(win, message);
+    wmove(win, cursor_row, cursor_col);
+    wrefresh(win);
+
+    if (duration_ms > 0) {
+        status_expires_at = monotonic_ms() + duration_ms;
+    } else {
+        status_expires_at = 0;
+        persistent_status = message;
+    }
 }
 
-static void prompt_win_message(WINDOW *win, const wchar_t *message)
+static int prompt_win_get_wch(WINDOW *win, wint_t *ch)
 {
-    prompt_win_clear(win);
-    mvwaddwstr(win, 0, 0, message);
-    wrefresh(win);
+    while (true) {
+        // Wait for input no longer than until the next timed event.
+        int timeout_ms = -1;
+        if (status_expires_at) {
+            long long remaining = status_expires_at - monotonic_ms();
+            timeout_ms = remaining > 0 ? (int)remaining : 0;
+        }
+
+        int tick_ms = clocks_next_tick_ms();
+        if (tick_ms >= 0 && (timeout_ms < 0 || tick_ms < timeout_ms)) {
+            timeout_ms = tick_ms;
+        }
+        wtimeout(win, timeout_ms);
+
+        int status = wget_wch(win, ch);
+        if (status != ERR || timeout_ms < 0) {
+            return status;
+        }
+
+        // No input arrived in time, so handle the timed events that are due.
+        if (status_expires_at && monotonic_ms() >= status_expires_at) {
+            prompt_win_message(win, persistent_status, 0);
+        }
+
+        if (game_clocks.running) {
+            // Refresh the prompt window last so that the cursor stays on the input line.
+            clocks_render();
+            wnoutrefresh(win);
+            doupdate();
+
+            if (clocks_flag_fell()) {
+                return ERR;
+            }
+        }
+    }
+}
+
+static long long monotonic_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
 }
 
-static void prompt_win_input(WINDOW *win, const wchar_t *prompt, wchar_t response[INPUT_BUF_SIZE + 1])
+static bool prompt_win_input(WINDOW *win, const wchar_t *prompt, wchar_t response[], int max_length)
 {
-    prompt_win_message(win, prompt);
+    wmove(win, PROMPT_INPUT_ROW, 0);
+    wclrtoeol(win);
+    waddwstr(win, prompt);
+    wrefresh(win);
 
     // Show the cursor.
     curs_set(1);
@@ -246,55 +560,42 @@ static void prompt_win_input(WINDOW *win, const wchar_t *prompt, wchar_t respons
     (void)prompt_end_row;
     getyx(win, prompt_end_row, prompt_end_col);
 
+    bool submitted = false;
     int i = 0;
-    while (true) {
+    while (!submitted) {
         wint_t ch;
-        int status = get_wch(&ch);
+        int status = prompt_win_get_wch(win, &ch);
 
         if (status == OK) {
             // Handle submission.
             if (ch == '\n' || ch == WEOF) {
-                break;
+                submitted = true;
+                continue;
             }
 
-            // Do not read in any more input after buffer size is reached. Continuing
+            // Do not read in any more input after the buffer is full. Continuing
             // allows the user to delete/modify characters before submitting.
-            if (i >= INPUT_BUF_SIZE) {
+            if (i >= max_length) {
                 continue;
             }
 
-            response[i] = (wchar_t)ch;
-
-            // Echo the input.
-            cchar_t input_char;
-            setcchar(&input_char, &response[i], WA_NORMAL, 0, NULL);
-            wadd_wch(win, &input_char);
-            wrefresh(win);
-
-            i++;
+            response[i++] = (wchar_t)ch;
+            prompt_win_echo(win, prompt_end_col, response, i);
         } else if (status == KEY_CODE_YES) {
-            int rows, cols;
-            (void)rows;
-            getyx(win, rows, cols);
-
             // TODO: Implement arrow keys.
-            if (ch == KEY_BACKSPACE && cols > prompt_end_col) {
+            if (ch == KEY_BACKSPACE && i > 0) {
                 // Handle backspace.
-                wmove(win, rows, cols - 1);
-                waddwstr(win, L" ");
-                wmove(win, rows, cols - 1);
-                wrefresh(win);
-
                 i--;
+                prompt_win_echo(win, prompt_end_col, response, i);
             } else if (ch == KEY_ENTER) {
                 // Handle submission.
-                break;
+                submitted = true;
             } else {
                 // Ignore other special keys.
                 continue;
             }
         } else {
-            // Break if an error reading input ocurred.
+            // Stop if an error reading input ocurred or the player's clock ran out.
             break;
         }
     }
@@ -302,12 +603,35 @@ static void prompt_win_input(WINDOW *win, const wchar_t *prompt, wchar_t respons
 
     // Re-hide the cursor.
     curs_set(0);
+
+    return submitted;
+}
+
+static void prompt_win_echo(WINDOW *win, int start_col, const wchar_t *response, int length)
+{
+    int rows, cols;
+    (void)rows;
+    getmaxyx(win, rows, cols);
+
+    // Keep the end of the answer, where the user is typing, on screen.
+    int visible = cols - start_col - 1;
+    if (visible < 1) {
+        visible = 1;
+    }
+    int first = length > visible ? length - visible : 0;
+
+    wmove(win, PROMPT_INPUT_ROW, start_col);
+    waddnwstr(win, response + first, length - first);
+    wclrtoeol(win);
+    wrefresh(win);
 }
 
 static int prompt_win_wscanf(WINDOW *win, const wchar_t *prompt, const wchar_t *format, ...)
 {
     wchar_t input[INPUT_BUF_SIZE + 1];
-    prompt_win_input(win, prompt, input);
+    if (!prompt_win_input(win, prompt, input, INPUT_BUF_SIZE)) {
+        return EOF;
+    }
 
     int return_value;
 
@@ -318,3 +642,121 @@ static int prompt_win_wscanf(WINDOW *win, const wchar_t *prompt, const wchar_t *
 
     return return_value;
 }
+
+static bool prompt_win_path(WINDOW *win, const wchar_t *prompt, char path[PATH_BUF_SIZE])
+{
+    // A path can be at most PATH_BUF_SIZE - 1 bytes, and each character takes at
+    // least one byte.
+    wchar_t input[PATH_BUF_SIZE];
+    if (!prompt_win_input(win, prompt, input, PATH_BUF_SIZE - 1) || input[0] == L'\0') {
+        return false;
+    }
+
+    size_t length = wcstombs(path, input, PATH_BUF_SIZE);
+    return length != (size_t)-1 && length < PATH_BUF_SIZE;
+}
+
+/* Clock utilities. */
+static void clocks_start(ChessPlayer *player)
+{
+    game_clocks.running = player;
+    game_clocks.started_at = monotonic_ms();
+}
+
+static bool clocks_stop(void)
+{
+    ChessPlayer *player = game_clocks.running;
+    if (!player) {
+        return true;
+    }
+
+    player->clock.remaining = clocks_remaining(player);
+    game_clocks.running = NULL;
+
+    bool in_time = !player->clock.enabled || player->clock.remaining > 0;
+    if (player->clock.enabled) {
+        if (in_time) {
+            player->clock.remaining += player->clock.increment;
+            if (player->clock.remaining > CLOCK_MAX_MS) {
+                player->clock.remaining = CLOCK_MAX_MS;
+            }
+        } else {
+            player->clock.remaining = 0;
+        }
+    }
+
+    clocks_render();
+    return in_time;
+}
+
+static bool clocks_flag_fell(void)
+{
+    ChessPlayer *player = game_clocks.running;
+    return player && player->clock.enabled && clocks_remaining(player) <= 0;
+}
+
+static long long clocks_remaining(const ChessPlayer *player)
+{
+    if (player != game_clocks.running || !player->clock.enabled) {
+        return player->clock.remaining;
+    }
+    return player->clock.remaining - (monotonic_ms() - game_clocks.started_at);
+}
+
+static int clocks_next_tick_ms(void)
+{
+    ChessPlayer *player = game_clocks.running;
+    if (!player || !player->clock.enabled) {
+        return -1;
+    }
+
+    long long remaining = clocks_remaining(player);
+    if (remaining <= 0) {
+        return 0;
+    }
+
+    // The display shows whole seconds, rounded up.
+    long long into_second = remaining % 1000;
+    return into_second ? (int)into_second : 1000;
+}
+
+static void clocks_render(void)
+{
+    WINDOW *win = game_clocks.win;
+    werase(win);
+
+    if (!game_clocks.white || !game_clocks.black || !game_clocks.white->clock.enabled) {
+        wnoutrefresh(win);
+        return;
+    }
+
+    int rows, cols;
+    (void)rows;
+    getmaxyx(win, rows, cols);
+
+    // Each clock is shown as "White 4:59", with the running clock highlighted.
+    const int clock_width = 12, spacing = 2;
+    wmove(win, 0, (cols - 2 * clock_width - spacing) / 2);
+
+    ChessPlayer *players[2] = { game_clocks.white, game_clocks.black };
+    for (int i = 0; i < 2; i++) {
+        long long remaining = clocks_remaining(players[i]);
+        long long seconds = remaining > 0 ? (remaining + 999) / 1000 : 0;
+
+        wchar_t clock_text[20] = { 0 };
+        swprintf(clock_text, 20, L"%ls %lld:%02lld", players[i]->is_white ? L"White" : L"Black",
+                 seconds / 60, seconds % 60);
+
+        if (players[i] == game_clocks.running) {
+            wattr_on(win, A_REVERSE, NULL);
+        }
+        waddwstr(win, clock_text);
+        wattr_off(win, A_REVERSE, NULL);
+
+        if (i == 0) {
+            wprintw(win, "%*s", spacing, "");
+        }
+    }
+
+    wnoutrefresh(win);
+}